@@ -6,6 +6,7 @@
 namespace Format {
 std::string ElapsedTime(long times); 
 std::string TimeFormat(int time);
+std::string ByteRate(float bytes_per_sec);
 };                                    // namespace Format
 
 #endif
\ No newline at end of file
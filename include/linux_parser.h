@@ -4,6 +4,7 @@
 #include <fstream>
 #include <regex>
 #include <string>
+#include <vector>
 
 namespace LinuxParser {
 // Paths
@@ -17,6 +18,16 @@ const std::string kMeminfoFilename{"/meminfo"};
 const std::string kVersionFilename{"/version"};
 const std::string kOSPath{"/etc/os-release"};
 const std::string kPasswordPath{"/etc/passwd"};
+const std::string kIoFilename{"/io"};
+const std::string kSchedstatFilename{"/schedstat"};
+const std::string kTaskDirectory{"/task/"};
+const std::string kDiskstatsFilename{"/diskstats"};
+const std::string kNetDevFilename{"/net/dev"};
+const std::string kSysBlockDirectory{"/sys/class/block/"};
+const std::string kLoadavgFilename{"/loadavg"};
+const std::string kCpuPressureFilename{"/pressure/cpu"};
+const std::string kMemoryPressureFilename{"/pressure/memory"};
+const std::string kIoPressureFilename{"/pressure/io"};
 
 // System
 float MemoryUtilization();
@@ -26,6 +37,10 @@ int TotalProcesses();
 int RunningProcesses();
 std::string OperatingSystem();
 std::string Kernel();
+void DiskBytes(long& read_bytes, long& write_bytes);
+void NetworkBytes(long& rx_bytes, long& tx_bytes);
+std::vector<float> LoadAverage();
+bool Pressure(const std::string& filename, float& some, float& full);
 
 // CPU
 enum CPUStates {
@@ -40,10 +55,9 @@ enum CPUStates {
   kGuest_,
   kGuestNice_
 };
-float CpuUtilization();
+std::vector<std::vector<long>> CpuStats(std::vector<int>& cores);
 long Jiffies();
 long ActiveJiffies();
-long ActiveJiffies(int pid);
 long IdleJiffies();
 
 // Processes
@@ -52,6 +66,15 @@ long Ram(int pid);
 int Uid(int pid);
 std::string User(int pid);
 long int UpTime(int pid);
+
+// Parsers for the content of the per-process files, used when the files are
+// read in a batch (see ProcReader)
+long ParseActiveJiffies(const std::string& stat);
+long ParseCpuTicks(const std::string& stat);
+bool ParseIoBytes(const std::string& io, long& read_bytes, long& write_bytes);
+bool ParseIoDelay(const std::string& stat, char& state, long& blkio_ticks);
+bool ParseSchedStat(const std::string& schedstat, long& run_ns, long& wait_ns,
+                    long& timeslices);
 };  // namespace LinuxParser
 
 #endif
\ No newline at end of file
@@ -9,8 +9,10 @@
 namespace NCursesDisplay {
 void Display(System& system, int n = 10);
 void DisplaySystem(System& system, WINDOW* window);
+void DisplayCores(System& system, WINDOW* window);
 void DisplayProcesses(std::vector<Process>& processes, WINDOW* window, int n);
 std::string ProgressBar(float percent);
+int CoreRows(int cores, int width);
 };  // namespace NCursesDisplay
 
 #endif
\ No newline at end of file
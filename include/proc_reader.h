@@ -0,0 +1,68 @@
+#ifndef PROC_READER_H
+#define PROC_READER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+Reads a batch of small /proc files for one tick.
+The synchronous backend issues open, read and close per file; the io_uring
+backend submits the same three steps as linked SQEs for a whole chunk of files
+into preregistered buffers and file slots, one io_uring_enter per chunk. Two
+chunks are in flight so the next one is submitted before the last is parsed.
+Every file is truncated to kBufferSize bytes.
+*/
+class ProcReader {
+ public:
+  ProcReader(bool use_io_uring = false);
+  ~ProcReader();
+  ProcReader(const ProcReader&) = delete;
+  ProcReader& operator=(const ProcReader&) = delete;
+
+  bool UsingIoUring() const;
+  // on_read is called with the index in paths and the content of every file
+  // that could be read, in completion order
+  void Read(const std::vector<std::string>& paths,
+            const std::function<void(std::size_t, const std::string&)>& on_read);
+  std::vector<int> List(const std::string& directory);  // numeric entries
+  long Syscalls() const;  // syscalls issued so far
+
+  static const std::size_t kBufferSize{4096};
+
+ private:
+  void ReadSync(const std::vector<std::string>& paths,
+                const std::function<void(std::size_t, const std::string&)>&
+                    on_read);
+  bool ReadOne(const std::vector<std::string>& paths, std::size_t index,
+               const std::function<void(std::size_t, const std::string&)>&
+                   on_read);
+  void ReadRing(const std::vector<std::string>& paths,
+                const std::function<void(std::size_t, const std::string&)>&
+                    on_read);
+  bool SetupRing();
+  void TeardownRing();
+
+  long syscalls_{0};
+  std::vector<char> buffer_;  // registered, one kBufferSize buffer per file slot
+  // io_uring state, ring_fd_ < 0 means the synchronous backend is used
+  int ring_fd_{-1};
+  unsigned slots_{0};  // files in flight per io_uring_enter
+  void* sq_ring_{nullptr};
+  void* cq_ring_{nullptr};
+  void* sqes_{nullptr};
+  std::size_t sq_ring_size_{0};
+  std::size_t cq_ring_size_{0};
+  std::size_t sqes_size_{0};
+  unsigned sq_entries_{0};
+  unsigned* sq_tail_{nullptr};
+  unsigned* sq_mask_{nullptr};
+  unsigned* sq_array_{nullptr};
+  unsigned* cq_head_{nullptr};
+  unsigned* cq_tail_{nullptr};
+  unsigned* cq_mask_{nullptr};
+  void* cqes_{nullptr};
+};
+
+#endif
@@ -1,14 +1,47 @@
 #ifndef PROCESS_H
 #define PROCESS_H
 
+#include <chrono>
 #include <string>
+#include <unordered_map>
+// How the CPU utilization of a process is measured
+// kJiffies: utime+stime+cutime+cstime against the system jiffies
+// kSchedstat: on-cpu ns from schedstat against wall-clock time per core
+enum class CpuAccounting { kJiffies, kSchedstat };
+
+// Schedstat counters of one thread
+struct ThreadSched {
+  long run_ns{0};  // on-cpu time
+  long wait_ns{0};  // run queue wait time
+  long timeslices{0};
+};
+
+// Counters of one process read in one tick, filled in by System::Sample
+struct ProcSample {
+  bool has_stat{false};
+  long active_jiffies{0};  // utime + stime + cutime + cstime
+  long cpu_ticks{0};       // utime + stime
+  long jiffies{0};         // system jiffies read in the same tick
+  char state{0};           // R, S, D, ...
+  long blkio_ticks{0};     // time spent waiting for block I/O
+  bool has_sched{false};
+  std::unordered_map<int, ThreadSched> threads;  // by tid
+  long run_ns{0};  // summed over the threads
+  bool has_io{false};  // only read for processes that may have done I/O
+  long read_bytes{0};
+  long write_bytes{0};
+  std::chrono::steady_clock::time_point time;     // when the CPU counters
+  std::chrono::steady_clock::time_point io_time;  // and io were read
+};
+
 /*
 Basic class for Process representation
 It contains relevant attributes as shown below
 */
 class Process {
  public:
-  Process(int id);
+  Process(int id, const ProcSample& sample,
+          CpuAccounting accounting = CpuAccounting::kJiffies);
   int Pid() const;                               // TODO: See src/process.cpp
   std::string User() const;                      // TODO: See src/process.cpp
   std::string Command() const;                   // TODO: See src/process.cpp
@@ -16,14 +49,32 @@ class Process {
   std::string Ram() const;                       // TODO: See src/process.cpp
   long int UpTime() const;                       // TODO: See src/process.cpp
   bool operator<(Process const& a) const;  // TODO: See src/process.cpp
-  void Update();
+  float ReadRate() const;   // bytes per second read from storage
+  float WriteRate() const;  // bytes per second written to storage
+  bool IoTracked() const;
+  float SchedLatency() const;  // ms waited on a run queue per timeslice
+  CpuAccounting Accounting() const;
+  void Update(const ProcSample& sample);
 
   // DONE: Declare any necessary private members
  private:
+    void UpdateSchedStat(const ProcSample& sample, double elapsed);
     int pidid_;
     long prev_actjif_{0};  // previous active jiff for the process
     long prev_jif_{0}; //previous total jiff
     float cpu_util_{0.0}; // cpu utilization 
+    CpuAccounting accounting_{CpuAccounting::kJiffies};
+    bool has_baseline_{false};  // the counters below come from a valid sample
+    std::unordered_map<int, ThreadSched> prev_threads_;  // by tid
+    long prev_cpu_ticks_{-1};  // -1 when stat was not read
+    float sched_latency_{0.0};
+    bool track_io_{false};  // the io counters below come from a valid read
+    long prev_read_bytes_{0};
+    long prev_write_bytes_{0};
+    std::chrono::steady_clock::time_point prev_io_time_;
+    std::chrono::steady_clock::time_point prev_time_;
+    float read_rate_{0.0};
+    float write_rate_{0.0};
 };
 
 #endif
\ No newline at end of file
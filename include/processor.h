@@ -1,12 +1,31 @@
 #ifndef PROCESSOR_H
 #define PROCESSOR_H
 
+#include <vector>
+
 class Processor {
  public:
-  float Utilization();  // TODO: See src/processor.cpp
+  Processor();
+  float Utilization();  // DONE: See src/processor.cpp
+  std::vector<float> CoreUtilization() const;
+  std::vector<int> CoreIds() const;  // CPU number of every core
+  float User() const;
+  float System() const;
+  float IOwait() const;
+  float Steal() const;
+  void Update(const std::vector<std::vector<long>>& stats,
+              const std::vector<int>& ids);
 
-  // TODO: Declare any necessary private members
+  // DONE: Declare any necessary private members
  private:
+  std::vector<int> core_ids_;  // filled in by prev_stats_'s initializer
+  std::vector<std::vector<long>> prev_stats_;  // [0] aggregate, [n] core n-1
+  float cpu_util_{0.0};
+  std::vector<float> core_util_;
+  float user_{0.0};    // user + nice
+  float system_{0.0};  // system + irq + softirq
+  float iowait_{0.0};
+  float steal_{0.0};
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,15 +1,23 @@
 #ifndef SYSTEM_H
 #define SYSTEM_H
 
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <mutex>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "proc_reader.h"
 #include "process.h"
 #include "processor.h"
 
 class System {
  public:
-  System();
+  System(CpuAccounting accounting = CpuAccounting::kJiffies,
+         bool io_uring = false);
   Processor& Cpu();                   // TODO: See src/system.cpp
   std::vector<Process>& Processes();  // TODO: See src/system.cpp
   float MemoryUtilization() const;          // TODO: See src/system.cpp
@@ -18,12 +26,83 @@ class System {
   int RunningProcesses() const ;             // TODO: See src/system.cpp
   std::string Kernel() const ;               // TODO: See src/system.cpp
   std::string OperatingSystem() const;      // TODO: See src/system.cpp
-  void Update();
-  void Refresh();
+  std::vector<float> LoadAverage() const;
+  bool CpuPressure(float& some, float& full) const;
+  bool MemoryPressure(float& some, float& full) const;
+  bool IoPressure(float& some, float& full) const;
+  float DiskReadRate() const;   // bytes per second
+  float DiskWriteRate() const;  // bytes per second
+  float NetRxRate() const;      // bytes per second
+  float NetTxRate() const;      // bytes per second
+  void IoVisible(std::size_t n);
+  CpuAccounting Accounting() const;
+  bool UsingIoUring() const;
+  long TickSyscalls() const;
+  float TickMs() const;
+  int Passes() const;
+  bool Ranked() const;
+  void Interval(std::chrono::milliseconds interval);
+  void FrameDrawn();
+  float FirstFrameMs() const;    // construction to the first frame
+  float FirstRankingMs() const;  // construction to the first CPU ranking
+  bool Update();
   // DONE: Define any necessary private members
  private:
+  // Samples of a run of pids, handed over while the pass goes on
+  struct Chunk {
+    std::vector<int> pids;
+    std::vector<ProcSample> samples;  // one per pid
+  };
+  // One read of /proc, collected off the UI thread
+  struct Pass {
+    std::vector<int> pids;
+    std::vector<std::vector<long>> cpu_stats;
+    std::vector<int> cpu_ids;
+    long disk_read{0}, disk_write{0};
+    long net_rx{0}, net_tx{0};
+    std::chrono::steady_clock::time_point time;  // of the totals above
+    long syscalls{0};
+    float ms{0};
+  };
+  std::vector<ProcSample> Sample(const std::vector<int>& pids);
+  Pass Collect();
+  void Refresh();
+  void Apply(const Chunk& chunk);
+  void Finish(const Pass& pass);
+
   Processor cpu_;
+  CpuAccounting accounting_;
   std::vector<Process> processes_ = {};
+  std::unordered_map<int, std::size_t> index_ = {};  // pid -> processes_
+  ProcReader reader_;
+  bool io_uring_{false};  // reader_ state as of the last Update()
+  long tick_syscalls_{0};  // per-process collection in the last pass
+  float tick_ms_{0};
+  // pids on screen, their /proc/<pid>/io is read by every pass
+  std::set<int> io_pids_ = {};
+  // CPU (and blkio) counter of every pid in the last pass, tells which ran
+  std::unordered_map<int, long> activity_ = {};
+  std::size_t io_visible_{10};  // rows shown on screen
+  long prev_disk_read_{0}, prev_disk_write_{0};
+  long prev_net_rx_{0}, prev_net_tx_{0};
+  std::chrono::steady_clock::time_point prev_time_;
+  float disk_read_rate_{0.0}, disk_write_rate_{0.0};
+  float net_rx_rate_{0.0}, net_tx_rate_{0.0};
+  std::chrono::milliseconds interval_{1000};
+  std::chrono::steady_clock::time_point next_pass_;
+  // startup instrumentation
+  std::chrono::steady_clock::time_point start_;
+  int passes_{0};         // finished and applied by Update()
+  bool ranked_{false};    // a pass has produced CPU figures
+  float first_frame_ms_{-1};
+  float first_ranking_ms_{-1};
+  // chunks of the running pass not taken by Update() yet
+  std::mutex chunks_mutex_;
+  std::vector<Chunk> chunks_ = {};
+  // the pass running in the background, started by Refresh() and applied by
+  // Update(). Declared last so it is destroyed, and its thread joined, before
+  // the members Collect() uses
+  std::future<Pass> pending_;
 };
 
 #endif
\ No newline at end of file
@@ -23,4 +23,17 @@ string Format::ElapsedTime(long seconds) {
   int hr = seconds / 3600;
   return string(Format::TimeFormat(hr) + ':' + Format::TimeFormat(min) + ':' +
                 Format::TimeFormat(sec));
-}
\ No newline at end of file
+}
+
+// INPUT: float bytes per second
+// OUTPUT: rate scaled to B/s, KB/s, MB/s or GB/s with one decimal
+string Format::ByteRate(float bytes_per_sec) {
+  const char* units[] = {"B/s", "KB/s", "MB/s", "GB/s"};
+  int unit = 0;
+  while (bytes_per_sec >= 1024 && unit < 3) {
+    bytes_per_sec /= 1024;
+    unit++;
+  }
+  string value = std::to_string(bytes_per_sec);
+  return value.substr(0, value.find('.') + 2) + " " + units[unit];
+}
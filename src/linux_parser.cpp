@@ -3,6 +3,7 @@
 #include <dirent.h>
 #include <unistd.h>
 
+#include <filesystem>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -14,33 +15,6 @@ using std::to_string;
 using std::vector;
 
 #define MB_TO_KB 1024;
-namespace {
-// used internally for LinuxParser, extract the accumulated cpu util info, used
-// for LinuxParser::CpuUtilization()
-void CpuInfo(long& total_idle_, long& total_nonidle_) {
-  std::ifstream stream(LinuxParser::kProcDirectory +
-                       LinuxParser::kStatFilename);
-  std::string line;
-  std::string key;
-  long user_, nice_, system_, idle_, iowaite_, irq_, softirq_, steal_, guest_,
-      guest_nice_;
-
-  if (stream.is_open()) {
-    while (std::getline(stream, line)) {
-      std::istringstream linestream(line);
-      linestream >> key;
-      // if (key.size() < 3) continue;
-      // if (key[0] == 'c' && key[1] == 'p') {
-      if (key == "cpu") {
-        linestream >> user_ >> nice_ >> system_ >> idle_ >> iowaite_ >> irq_ >>
-            softirq_ >> steal_ >> guest_ >> guest_nice_;
-        total_idle_ = idle_ + iowaite_;
-        total_nonidle_ = user_ + nice_ + system_ + irq_ + softirq_ + steal_;
-      }
-    }
-  }
-}
-}  // namespace
 // DONE: An example of how to read data from the filesystem
 string LinuxParser::OperatingSystem() {
   string line;
@@ -160,14 +134,12 @@ long LinuxParser::Jiffies() {
   return 0;  // return 0 if an error (for debug)
 }
 
-// DONE: Read and return the number of active jiffies for a PID
-long LinuxParser::ActiveJiffies(int pid) {
+// DONE: Parse the active jiffies out of the content of /proc/<pid>/stat
+long LinuxParser::ParseActiveJiffies(const std::string& stat) {
   // https://stackoverflow.com/questions/16726779/how-do-i-get-the-total-cpu-usage-of-an-application-from-proc-pid-stat/16736599#16736599
-  std::ifstream stream(kProcDirectory + std::to_string(pid) + kStatFilename);
-  std::string line, strunused_;
+  std::string strunused_;
   long intunused_, utime_, stime_, cutime_, cstime_;
-  std::getline(stream, line);
-  std::istringstream linestream(line);
+  std::istringstream linestream(stat);
   linestream >> intunused_ >> strunused_ >> strunused_;
   for (int i = 4; i < 18; i++) {
     switch (i) {
@@ -248,22 +220,6 @@ long LinuxParser::IdleJiffies() {
   return 0;
 }
 
-// DONE: Read and return CPU utilization
-float LinuxParser::CpuUtilization() {
-  // https://stackoverflow.com/questions/23367857/accurate-calculation-of-cpu-usage-given-in-percentage-in-linux
-  long prev_idle_, prev_nonidle_;
-  long idle_, nonidle_;
-  ::CpuInfo(prev_idle_, prev_nonidle_);
-  usleep(
-      50000);  // create time invertal for calculate the instantaneous cpu util
-  ::CpuInfo(idle_, nonidle_);
-  //std::cout << prev_nonidle_ << '\n';
-  //std::cout << "idle: " << idle_ << ", nonidle: " << nonidle_ << '\n';
-  float cpu_util = 1.0 * (nonidle_ - prev_nonidle_) /
-                   (nonidle_ - prev_nonidle_ + idle_ - prev_idle_);
-  return cpu_util;
-}
-
 // DONE: Read and return the total number of processes
 int LinuxParser::TotalProcesses() {
   std::ifstream stream(kProcDirectory + kStatFilename);
@@ -365,3 +321,175 @@ long LinuxParser::UpTime(int pid) {
   linestream >> uptime_;
   return LinuxParser::UpTime() - uptime_ / sysconf(_SC_CLK_TCK);
 }
+
+// Parse read_bytes / write_bytes out of the content of /proc/<pid>/io
+bool LinuxParser::ParseIoBytes(const std::string& io, long& read_bytes,
+                               long& write_bytes) {
+  std::istringstream stream(io);
+  std::string line;
+  std::string key;
+  long value;
+  bool found_read{false}, found_write{false};
+  while (std::getline(stream, line)) {
+    std::replace(line.begin(), line.end(), ':', ' ');
+    std::istringstream linestream(line);
+    linestream >> key >> value;
+    if (key == "read_bytes") {
+      read_bytes = value;
+      found_read = true;
+    } else if (key == "write_bytes") {
+      write_bytes = value;
+      found_write = true;
+    }
+  }
+  return found_read && found_write;
+}
+
+// Read the accumulated bytes read / written by the block devices
+// Only whole physical disks are counted: partitions (they have a "partition"
+// file in sysfs) and stacked devices such as dm-* and md* (they have
+// "slaves") would count the same traffic twice, loop / ram disks never hit a
+// disk of their own
+void LinuxParser::DiskBytes(long& read_bytes, long& write_bytes) {
+  const long kSectorSize{512};  // diskstats always counts 512 byte sectors
+  read_bytes = 0;
+  write_bytes = 0;
+  std::ifstream stream(kProcDirectory + kDiskstatsFilename);
+  std::string line, name;
+  long major, minor, reads, reads_merged, sectors_read, read_ms, writes,
+      writes_merged, sectors_written;
+  while (std::getline(stream, line)) {
+    std::istringstream linestream(line);
+    linestream >> major >> minor >> name >> reads >> reads_merged >>
+        sectors_read >> read_ms >> writes >> writes_merged >> sectors_written;
+    if (!linestream) continue;
+    if (name.rfind("loop", 0) == 0 || name.rfind("ram", 0) == 0 ||
+        name.rfind("zram", 0) == 0)
+      continue;
+    std::replace(name.begin(), name.end(), '/', '!');  // sysfs naming
+    std::filesystem::path device{kSysBlockDirectory + name};
+    std::error_code error;
+    if (std::filesystem::exists(device / "partition", error)) continue;
+    if (!std::filesystem::is_empty(device / "slaves", error) && !error)
+      continue;
+    read_bytes += sectors_read * kSectorSize;
+    write_bytes += sectors_written * kSectorSize;
+  }
+}
+
+// Read the accumulated bytes received / transmitted by the network interfaces
+// The loopback interface is skipped since it never leaves the host
+void LinuxParser::NetworkBytes(long& rx_bytes, long& tx_bytes) {
+  rx_bytes = 0;
+  tx_bytes = 0;
+  std::ifstream stream(kProcDirectory + kNetDevFilename);
+  std::string line, iface;
+  long rx, tx, unused_;
+  while (std::getline(stream, line)) {
+    std::replace(line.begin(), line.end(), ':', ' ');
+    std::istringstream linestream(line);
+    linestream >> iface >> rx;
+    if (!linestream || iface == "lo") continue;  // also skips the header
+    for (int i = 0; i < 7; i++) linestream >> unused_;
+    linestream >> tx;
+    if (!linestream) continue;
+    rx_bytes += rx;
+    tx_bytes += tx;
+  }
+}
+
+// Read every cpu line of /proc/stat in one pass
+// OUTPUT: [0] the aggregate "cpu" line, [n] the n-th "cpu<N>" line, each
+// holding the jiffies indexed by CPUStates (missing trailing fields read as 0)
+// and cores[n - 1] its N, offline CPUs have no line
+vector<vector<long>> LinuxParser::CpuStats(vector<int>& cores) {
+  vector<vector<long>> stats;
+  cores.clear();
+  std::ifstream stream(kProcDirectory + kStatFilename);
+  std::string line;
+  std::string key;
+  while (std::getline(stream, line)) {
+    std::istringstream linestream(line);
+    linestream >> key;
+    if (key.rfind("cpu", 0) != 0) break;  // cpu lines come first
+    if (key.size() > 3) cores.push_back(std::stoi(key.substr(3)));
+    vector<long> jiffies(kGuestNice_ + 1, 0);
+    for (long& value : jiffies) {
+      if (!(linestream >> value)) break;
+    }
+    stats.push_back(jiffies);
+  }
+  return stats;
+}
+
+// Read the 1, 5 and 15 minutes load averages
+vector<float> LinuxParser::LoadAverage() {
+  vector<float> load(3, 0.0);
+  std::ifstream stream(kProcDirectory + kLoadavgFilename);
+  std::string line;
+  std::getline(stream, line);
+  std::istringstream linestream(line);
+  linestream >> load[0] >> load[1] >> load[2];
+  return load;
+}
+
+// Read the avg10 share of time some / all tasks stalled on a resource
+// INPUT: one of the k*PressureFilename paths
+// OUTPUT: false if the kernel does not expose pressure stall information
+bool LinuxParser::Pressure(const std::string& filename, float& some,
+                           float& full) {
+  std::ifstream stream(kProcDirectory + filename);
+  if (!stream.is_open()) return false;
+  std::string line;
+  std::string key, avg10;
+  some = 0.0;
+  full = 0.0;
+  while (std::getline(stream, line)) {
+    std::replace(line.begin(), line.end(), '=', ' ');
+    std::istringstream linestream(line);
+    float value;
+    linestream >> key >> avg10 >> value;
+    if (!linestream || avg10 != "avg10") continue;
+    if (key == "some")
+      some = value / 100;
+    else if (key == "full")
+      full = value / 100;
+  }
+  return true;
+}
+
+// Parse the content of a /proc/<pid>/task/<tid>/schedstat file
+bool LinuxParser::ParseSchedStat(const std::string& schedstat, long& run_ns,
+                                 long& wait_ns, long& timeslices) {
+  std::istringstream linestream(schedstat);
+  return static_cast<bool>(linestream >> run_ns >> wait_ns >> timeslices);
+}
+
+// Parse utime + stime (fields 14 and 15) out of the content of
+// /proc/<pid>/stat: the clock ticks of the whole thread group, the threads
+// that already exited included and the children left out
+long LinuxParser::ParseCpuTicks(const std::string& stat) {
+  size_t end = stat.rfind(')');
+  if (end == std::string::npos) return 0;
+  std::istringstream linestream(stat.substr(end + 1));
+  std::string unused_;
+  long utime_{0}, stime_{0};
+  for (int i = 3; i < 14; i++) linestream >> unused_;
+  linestream >> utime_ >> stime_;
+  return utime_ + stime_;
+}
+
+// Parse the state (field 3) and the aggregated block I/O delay in clock ticks
+// (field 42, delayacct_blkio_ticks) out of the content of /proc/<pid>/stat
+bool LinuxParser::ParseIoDelay(const std::string& stat, char& state,
+                               long& blkio_ticks) {
+  // the command (field 2) may contain spaces, the fields after it do not
+  size_t end = stat.rfind(')');
+  if (end == std::string::npos) return false;
+  std::istringstream linestream(stat.substr(end + 1));
+  std::string unused_;
+  linestream >> state;
+  for (int i = 4; i < 42; i++) linestream >> unused_;
+  linestream >> blkio_ticks;
+  return static_cast<bool>(linestream);
+}
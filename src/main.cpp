@@ -1,7 +1,76 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
 #include "ncurses_display.h"
 #include "system.h"
 
-int main() {
-  System system;
+namespace {
+// Run ticks without the display and report the cost of the per-process
+// collection for the synchronous and the io_uring reader
+void Benchmark(CpuAccounting accounting, int ticks) {
+  for (bool io_uring : {false, true}) {
+    // startup as the display does it: a frame from the minimal scan, then
+    // one per update until the first CPU ranking; the ticks are shortened
+    System system(accounting, io_uring);
+    system.Interval(std::chrono::milliseconds(100));
+    system.FrameDrawn();
+    while (!system.Ranked()) {
+      if (system.Update())
+        system.FrameDrawn();
+      else
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    long syscalls{0};
+    double pass_ms{0}, ui_ms{0};
+    for (int tick = 0; tick < ticks; tick++) {
+      for (int passes = system.Passes(); system.Passes() == passes;) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        auto start = std::chrono::steady_clock::now();
+        system.Update();
+        ui_ms += std::chrono::duration<double, std::milli>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+      }
+      syscalls += system.TickSyscalls();
+      pass_ms += system.TickMs();
+    }
+    std::cout << (system.UsingIoUring() ? "io_uring" : "sync") << ": "
+              << system.Processes().size() << " processes, "
+              << syscalls / ticks << " syscalls/tick, " << pass_ms / ticks
+              << " ms/pass, " << ui_ms / ticks
+              << " ms/tick on the UI thread, first frame "
+              << system.FirstFrameMs()
+              << " ms, first ranking " << system.FirstRankingMs() << " ms\n";
+    if (io_uring && !system.UsingIoUring())
+      std::cout << "io_uring is not supported here, fell back to sync\n";
+  }
+}
+}  // namespace
+
+// --schedstat measures process CPU from the per-thread schedstat files, more
+//   precise but it costs a directory listing and one read per thread
+// --io-uring reads the per-process files in batches through io_uring
+// --bench N runs N ticks with both readers and prints their cost
+int main(int argc, char* argv[]) {
+  CpuAccounting accounting{CpuAccounting::kJiffies};
+  bool io_uring{false};
+  int bench_ticks{0};
+  for (int i = 1; i < argc; i++) {
+    std::string arg{argv[i]};
+    if (arg == "--schedstat")
+      accounting = CpuAccounting::kSchedstat;
+    else if (arg == "--io-uring")
+      io_uring = true;
+    else if (arg == "--bench" && i + 1 < argc)
+      bench_ticks = std::stoi(argv[++i]);
+  }
+  if (bench_ticks > 0) {
+    Benchmark(accounting, bench_ticks);
+    return 0;
+  }
+  System system(accounting, io_uring);
   NCursesDisplay::Display(system);
-}
\ No newline at end of file
+}
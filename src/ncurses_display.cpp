@@ -1,4 +1,5 @@
 #include <curses.h>
+#include <algorithm>
 #include <chrono>
 #include <string>
 #include <thread>
@@ -10,6 +11,29 @@
 
 using std::string;
 using std::to_string;
+using std::vector;
+
+namespace {
+// how often the background pass is checked for rows to draw
+auto const kPoll{std::chrono::milliseconds(25)};
+
+// heatmap rows are capped so the process list still fits on screen
+int const kMaxCoreRows{16};
+int const kCoreLabelWidth{6};  // "  128 " in front of every heatmap row
+int const kMinProcessRows{5};
+
+// Share as a percentage with one decimal, e.g. 0.1234 -> "12.3%"
+string Percent(float share) {
+  string value{to_string(share * 100)};
+  return value.substr(0, value.find('.') + 2) + "%";
+}
+
+// Pressure stall avg10 of some / full tasks, "n/a" without PSI support
+string Pressure(bool supported, float some, float full, bool with_full) {
+  if (!supported) return "n/a";
+  return with_full ? Percent(some) + "/" + Percent(full) : Percent(some);
+}
+}  // namespace
 
 // 50 bars uniformly displayed from 0 - 100 %
 // 2% is one bar(|)
@@ -37,48 +61,123 @@ void NCursesDisplay::DisplaySystem(System& system, WINDOW* window) {
   mvwprintw(window, row, 10, "");
   wprintw(window, ProgressBar(system.Cpu().Utilization()).c_str());
   wattroff(window, COLOR_PAIR(1));
+  Processor& cpu = system.Cpu();
+  mvwprintw(window, ++row, 10, "%-60s",
+            ("usr " + Percent(cpu.User()) + "  sys " + Percent(cpu.System()) +
+             "  iowait " + Percent(cpu.IOwait()) + "  steal " +
+             Percent(cpu.Steal()))
+                .c_str());
   mvwprintw(window, ++row, 2, "Memory: ");
   wattron(window, COLOR_PAIR(1));
   mvwprintw(window, row, 10, "");
   wprintw(window, ProgressBar(system.MemoryUtilization()).c_str());
   wattroff(window, COLOR_PAIR(1));
-  mvwprintw(window, ++row, 2,
-            ("Total Processes: " + to_string(system.TotalProcesses())).c_str());
-  mvwprintw(
-      window, ++row, 2,
-      ("Running Processes: " + to_string(system.RunningProcesses())).c_str());
+  vector<float> load = system.LoadAverage();
+  string loadavg;
+  for (float l : load) loadavg += to_string(l).substr(0, 4) + " ";
+  // some: at least one task stalled, full: all non-idle tasks stalled
+  float some, full;
+  bool psi = system.CpuPressure(some, full);
+  string pressure{"cpu " + Pressure(psi, some, full, false)};
+  psi = system.MemoryPressure(some, full);
+  pressure += " mem " + Pressure(psi, some, full, true);
+  psi = system.IoPressure(some, full);
+  pressure += " io " + Pressure(psi, some, full, true);
+  mvwprintw(window, ++row, 2, "%-74s",
+            ("Load: " + loadavg + " PSI " + pressure).c_str());
+  // whole-system disk and network throughput over the last interval
+  mvwprintw(window, ++row, 2, "%-70s",
+            ("Disk: R " + Format::ByteRate(system.DiskReadRate()) + "  W " +
+             Format::ByteRate(system.DiskWriteRate()) + "   Net: RX " +
+             Format::ByteRate(system.NetRxRate()) + "  TX " +
+             Format::ByteRate(system.NetTxRate()))
+                .c_str());
+  mvwprintw(window, ++row, 2, "%-60s",
+            ("Total Processes: " + to_string(system.TotalProcesses()) +
+             "  Running Processes: " + to_string(system.RunningProcesses()))
+                .c_str());
   mvwprintw(window, ++row, 2,
             ("Up Time: " + Format::ElapsedTime(system.UpTime())).c_str());
   wrefresh(window);
 }
 
+// Rows of the heatmap needed to show every core in a window of that width
+int NCursesDisplay::CoreRows(int cores, int width) {
+  int per_row = std::max(1, width - 2 - kCoreLabelWidth);
+  return std::min(kMaxCoreRows, std::max(1, (cores + per_row - 1) / per_row));
+}
+
+// One cell per core, the digit is the utilization decile ('*' when pegged)
+// and the color moves from blue (idle) to red (busy). A row is labelled with
+// the CPU number of its first cell
+void NCursesDisplay::DisplayCores(System& system, WINDOW* window) {
+  vector<float> cores = system.Cpu().CoreUtilization();
+  vector<int> ids = system.Cpu().CoreIds();
+  int per_row = std::max(1, getmaxx(window) - 2 - kCoreLabelWidth);
+  int rows = getmaxy(window) - 2;
+  for (int row = 0; row < rows; row++) {
+    size_t first = row * per_row;
+    if (first >= cores.size()) break;
+    mvwprintw(window, row + 1, 1, "%5d ", ids[first]);
+    for (size_t i = first; i < cores.size() && i < first + per_row; i++) {
+      int decile = static_cast<int>(cores[i] * 10);
+      int pair = cores[i] < 0.25 ? 1 : cores[i] < 0.5 ? 3 : cores[i] < 0.75 ? 4
+                                                                        : 5;
+      wattron(window, COLOR_PAIR(pair));
+      waddch(window, decile >= 10 ? '*' : '0' + decile);
+      wattroff(window, COLOR_PAIR(pair));
+    }
+  }
+  wrefresh(window);
+}
+
 void NCursesDisplay::DisplayProcesses(std::vector<Process>& processes,
                                       WINDOW* window, int n) {
   int row{0};
   int const pid_column{2};
   int const user_column{9};
   int const cpu_column{16};
-  int const ram_column{26};
-  int const time_column{35};
-  int const command_column{46};
+  int const latency_column{24};
+  int const ram_column{33};
+  int const time_column{42};
+  int const read_column{53};
+  int const write_column{65};
+  int const command_column{77};
   wattron(window, COLOR_PAIR(2));
   mvwprintw(window, ++row, pid_column, "PID");
   mvwprintw(window, row, user_column, "USER");
   mvwprintw(window, row, cpu_column, "CPU[%%]");
+  mvwprintw(window, row, latency_column, "LAT[ms]");
   mvwprintw(window, row, ram_column, "RAM[MB]");
   mvwprintw(window, row, time_column, "TIME+");
+  mvwprintw(window, row, read_column, "IO-READ");
+  mvwprintw(window, row, write_column, "IO-WRITE");
   mvwprintw(window, row, command_column, "COMMAND");
   wattroff(window, COLOR_PAIR(2));
+  n = std::min<int>(n, processes.size());
   for (int i = 0; i < n; ++i) {
     mvwprintw(window, ++row, pid_column, to_string(processes[i].Pid()).c_str());
     mvwprintw(window, row, user_column, processes[i].User().c_str());
     float cpu = processes[i].CpuUtilization() * 100;
     mvwprintw(window, row, cpu_column, to_string(cpu).substr(0, 4).c_str());
+    // run queue wait per timeslice, only known with schedstat accounting
+    string latency{"-"};
+    if (processes[i].Accounting() == CpuAccounting::kSchedstat)
+      latency = to_string(processes[i].SchedLatency()).substr(0, 5);
+    mvwprintw(window, row, latency_column, "%-8s", latency.c_str());
     mvwprintw(window, row, ram_column, processes[i].Ram().c_str());
     mvwprintw(window, row, time_column,
               Format::ElapsedTime(processes[i].UpTime()).c_str());
+    // untracked: /proc/<pid>/io is not readable (another user, no root)
+    bool io = processes[i].IoTracked();
+    mvwprintw(window, row, read_column, "%-11s",
+              (io ? Format::ByteRate(processes[i].ReadRate()) : "-").c_str());
+    mvwprintw(window, row, write_column, "%-11s",
+              (io ? Format::ByteRate(processes[i].WriteRate()) : "-").c_str());
     mvwprintw(window, row, command_column,
-              processes[i].Command().substr(0, window->_maxx - 46).c_str());
+              processes[i].Command()
+                  .substr(0, window->_maxx - command_column)
+                  .c_str());
   }
 }
 
@@ -89,23 +188,45 @@ void NCursesDisplay::Display(System& system, int n) {
   start_color();  // enable color
 
   int x_max{getmaxx(stdscr)};
-  WINDOW* system_window = newwin(9, x_max - 1, 0, 0);
-  WINDOW* process_window =
-      newwin(3 + n, x_max - 1, system_window->_maxy + 1, 0);
+  int y_max{getmaxy(stdscr)};
+  int y{0};
+  WINDOW* system_window = newwin(11, x_max - 1, y, 0);
+  y += getmaxy(system_window);
+  // the windows share what is left of the terminal: the heatmap gives up
+  // rows first so that kMinProcessRows processes stay visible
+  int cores = system.Cpu().CoreUtilization().size();
+  int core_rows = std::min(CoreRows(cores, x_max - 1),
+                           std::max(1, y_max - y - 2 - 3 - kMinProcessRows));
+  WINDOW* core_window = newwin(2 + core_rows, x_max - 1, y, 0);
+  y += getmaxy(core_window);
+  n = std::max(1, std::min(n, y_max - y - 3));
+  WINDOW* process_window = newwin(3 + n, x_max - 1, y, 0);
+  system.IoVisible(n);
 
   while (1) {
     init_pair(1, COLOR_BLUE, COLOR_BLACK);
     init_pair(2, COLOR_GREEN, COLOR_BLACK);
+    init_pair(3, COLOR_BLACK, COLOR_GREEN);
+    init_pair(4, COLOR_BLACK, COLOR_YELLOW);
+    init_pair(5, COLOR_WHITE, COLOR_RED);
     box(system_window, 0, 0);
+    box(core_window, 0, 0);
+    mvwprintw(core_window, 0, 2, " Cores ");
     box(process_window, 0, 0);
+    if (system.FirstRankingMs() >= 0)
+      mvwprintw(process_window, 0, 2, " first frame %.0f ms, ranked %.0f ms ",
+                system.FirstFrameMs(), system.FirstRankingMs());
     DisplaySystem(system, system_window);
+    DisplayCores(system, core_window);
     DisplayProcesses(system.Processes(), process_window, n);
     wrefresh(system_window);
+    wrefresh(core_window);
     wrefresh(process_window);
     refresh();
-    system.Refresh();
-    std::this_thread::sleep_for(std::chrono::seconds(1));
-    system.Update();
+    system.FrameDrawn();
+    // the passes over /proc run in the background, redraw as soon as one of
+    // them has rows to show
+    while (!system.Update()) std::this_thread::sleep_for(kPoll);
   }
   endwin();
 }
\ No newline at end of file
@@ -0,0 +1,293 @@
+#include "proc_reader.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+// sqe->file_index (openat into a registered file slot) is tested through
+// IORING_FILE_INDEX_ALLOC, which first appears in the 5.19 headers
+#if defined(IORING_FILE_INDEX_ALLOC) && defined(__NR_io_uring_setup)
+#define PROC_READER_IO_URING 1
+#endif
+
+using std::size_t;
+using std::string;
+using std::vector;
+
+namespace {
+const unsigned kRingEntries{256};
+const unsigned kSlots{64};  // 3 SQEs per file must fit in kRingEntries
+}  // namespace
+
+// The io_uring backend is only used if the ring can be set up and a probe
+// read of /proc/self/stat succeeds, otherwise reads stay synchronous
+ProcReader::ProcReader(bool use_io_uring) {
+  buffer_.resize(kSlots * kBufferSize);
+  if (use_io_uring && !SetupRing()) TeardownRing();
+}
+
+ProcReader::~ProcReader() { TeardownRing(); }
+
+bool ProcReader::UsingIoUring() const { return ring_fd_ >= 0; }
+
+long ProcReader::Syscalls() const { return syscalls_; }
+
+void ProcReader::Read(
+    const vector<string>& paths,
+    const std::function<void(size_t, const string&)>& on_read) {
+  if (UsingIoUring())
+    ReadRing(paths, on_read);
+  else
+    ReadSync(paths, on_read);
+}
+
+// open, read and close every file in turn
+void ProcReader::ReadSync(
+    const vector<string>& paths,
+    const std::function<void(size_t, const string&)>& on_read) {
+  for (size_t i = 0; i < paths.size(); i++) ReadOne(paths, i, on_read);
+}
+
+// Uses a buffer of its own: after a ring failure the kernel may still be
+// writing into the registered ones
+bool ProcReader::ReadOne(
+    const vector<string>& paths, size_t index,
+    const std::function<void(size_t, const string&)>& on_read) {
+  char buffer[kBufferSize];
+  syscalls_++;
+  int fd = open(paths[index].c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  syscalls_ += 2;
+  ssize_t size = read(fd, buffer, kBufferSize);
+  close(fd);
+  if (size < 0) return false;
+  on_read(index, string(buffer, size));
+  return true;
+}
+
+// Numeric entries of a directory, read with raw getdents64 so every syscall
+// is accounted for
+vector<int> ProcReader::List(const string& directory) {
+  vector<int> ids;
+  syscalls_++;
+  int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) return ids;
+  char buffer[kBufferSize];
+  long size;
+  do {
+    syscalls_++;
+    size = syscall(SYS_getdents64, fd, buffer, kBufferSize);
+    for (long offset = 0; offset < size;) {
+      auto* entry = reinterpret_cast<struct dirent64*>(buffer + offset);
+      if (isdigit(entry->d_name[0])) ids.push_back(atoi(entry->d_name));
+      offset += entry->d_reclen;
+    }
+  } while (size > 0);
+  syscalls_++;
+  close(fd);
+  return ids;
+}
+
+#ifdef PROC_READER_IO_URING
+
+namespace {
+// Map one of the io_uring regions, nullptr on failure
+void* Map(int ring_fd, size_t size, off_t offset) {
+  void* region = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+  return region == MAP_FAILED ? nullptr : region;
+}
+}  // namespace
+
+bool ProcReader::SetupRing() {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = syscall(__NR_io_uring_setup, kRingEntries, &params);
+  if (ring_fd_ < 0) return false;
+
+  sq_entries_ = params.sq_entries;
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap) {
+    sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    cq_ring_size_ = sq_ring_size_;
+  }
+  sq_ring_ = Map(ring_fd_, sq_ring_size_, IORING_OFF_SQ_RING);
+  if (sq_ring_ == nullptr) return false;
+  cq_ring_ = single_mmap ? sq_ring_
+                         : Map(ring_fd_, cq_ring_size_, IORING_OFF_CQ_RING);
+  if (cq_ring_ == nullptr) return false;
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = Map(ring_fd_, sqes_size_, IORING_OFF_SQES);
+  if (sqes_ == nullptr) return false;
+
+  char* sq = static_cast<char*>(sq_ring_);
+  char* cq = static_cast<char*>(cq_ring_);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  cqes_ = cq + params.cq_off.cqes;
+
+  // empty file slots for the direct descriptors and one buffer per slot
+  vector<int> files(kSlots, -1);
+  if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_FILES,
+              files.data(), kSlots) < 0)
+    return false;
+  vector<iovec> buffers(kSlots);
+  for (unsigned slot = 0; slot < kSlots; slot++) {
+    buffers[slot].iov_base = buffer_.data() + slot * kBufferSize;
+    buffers[slot].iov_len = kBufferSize;
+  }
+  if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_BUFFERS,
+              buffers.data(), kSlots) < 0)
+    return false;
+  slots_ = kSlots;
+
+  // older kernels accept the ring but reject direct descriptors
+  bool probed{false};
+  ReadRing({"/proc/self/stat"},
+           [&probed](size_t, const string&) { probed = true; });
+  syscalls_ = 0;
+  return probed;
+}
+
+void ProcReader::TeardownRing() {
+  if (sqes_ != nullptr) munmap(sqes_, sqes_size_);
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_)
+    munmap(cq_ring_, cq_ring_size_);
+  if (sq_ring_ != nullptr) munmap(sq_ring_, sq_ring_size_);
+  if (ring_fd_ >= 0) close(ring_fd_);
+  sqes_ = sq_ring_ = cq_ring_ = nullptr;
+  ring_fd_ = -1;
+  slots_ = 0;
+}
+
+// Each file is an openat into slot k, a fixed-buffer read from slot k and a
+// close of slot k, linked so they run in order. The read is hard linked
+// because a short read, which is the normal case for /proc, would otherwise
+// cancel the close.
+// The slots are split into two halves that take turns: each io_uring_enter
+// submits the next chunk into the free half and waits only for the chunk in
+// the other half. The ops of the new chunk that the kernel can not complete
+// inline run on its workers while the completions are parsed
+void ProcReader::ReadRing(
+    const vector<string>& paths,
+    const std::function<void(size_t, const string&)>& on_read) {
+  io_uring_sqe* sqes = static_cast<io_uring_sqe*>(sqes_);
+  io_uring_cqe* cqes = static_cast<io_uring_cqe*>(cqes_);
+  size_t const per_chunk = slots_ / 2;
+  size_t const chunks = (paths.size() + per_chunk - 1) / per_chunk;
+  // chunk c holds files [c * per_chunk, ...) in the slots of half c % 2
+  auto slot_of = [per_chunk](size_t file) {
+    return (file / per_chunk) % 2 * per_chunk + file % per_chunk;
+  };
+  vector<bool> delivered(paths.size(), false);
+  unsigned remaining[2] = {0, 0};  // CQEs still due per half
+  unsigned submit = 0;
+  size_t queued = 0;  // chunks handed to the ring
+  size_t oldest = 0;  // first chunk not fully completed
+  while (oldest < chunks) {
+    for (; queued < chunks && queued < oldest + 2; queued++) {
+      size_t first = queued * per_chunk;
+      size_t count = std::min(per_chunk, paths.size() - first);
+      unsigned tail = *sq_tail_;
+      auto next = [&]() {
+        unsigned index = tail++ & *sq_mask_;
+        sq_array_[index] = index;
+        memset(&sqes[index], 0, sizeof(io_uring_sqe));
+        return &sqes[index];
+      };
+      for (size_t file = first; file < first + count; file++) {
+        unsigned slot = slot_of(file);
+        io_uring_sqe* sqe = next();
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<__u64>(paths[file].c_str());
+        sqe->open_flags = O_RDONLY;  // O_CLOEXEC is rejected for direct fds
+        sqe->file_index = slot + 1;
+        sqe->flags = IOSQE_IO_LINK;
+        sqe->user_data = file * 3;
+
+        sqe = next();
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->fd = slot;
+        sqe->addr =
+            reinterpret_cast<__u64>(buffer_.data() + slot * kBufferSize);
+        sqe->len = kBufferSize;
+        sqe->buf_index = slot;
+        sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+        sqe->user_data = file * 3 + 1;
+
+        sqe = next();
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->file_index = slot + 1;
+        sqe->user_data = file * 3 + 2;
+      }
+      __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+      remaining[queued % 2] = count * 3;
+      submit += count * 3;
+    }
+
+    syscalls_++;
+    int submitted = syscall(__NR_io_uring_enter, ring_fd_, submit,
+                            remaining[oldest % 2], IORING_ENTER_GETEVENTS,
+                            nullptr, 0);
+    if (submitted < 0) {
+      if (errno == EINTR) continue;
+      // SQEs may still be in flight and CQEs unread, so the ring can not be
+      // reused: drop it and read what is left synchronously
+      TeardownRing();
+      for (size_t file = 0; file < paths.size(); file++) {
+        if (!delivered[file]) ReadOne(paths, file, on_read);
+      }
+      return;
+    }
+    submit -= std::min<unsigned>(submit, submitted);
+    unsigned head = *cq_head_;
+    unsigned cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != cq_tail; head++) {
+      const io_uring_cqe& cqe = cqes[head & *cq_mask_];
+      size_t file = cqe.user_data / 3;
+      remaining[file / per_chunk % 2]--;
+      if (cqe.user_data % 3 == 1 && cqe.res >= 0) {
+        on_read(file, string(buffer_.data() + slot_of(file) * kBufferSize,
+                             cqe.res));
+        delivered[file] = true;
+      }
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    // a half is free again once all CQEs of its chunk are in
+    while (oldest < queued && remaining[oldest % 2] == 0) oldest++;
+  }
+}
+
+#else
+
+bool ProcReader::SetupRing() { return false; }
+
+void ProcReader::TeardownRing() {}
+
+void ProcReader::ReadRing(
+    const vector<string>& paths,
+    const std::function<void(size_t, const string&)>& on_read) {
+  ReadSync(paths, on_read);
+}
+
+#endif
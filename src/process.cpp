@@ -2,6 +2,7 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <cctype>
 #include <sstream>
 #include <string>
@@ -12,10 +13,21 @@ using std::string;
 using std::to_string;
 using std::vector;
 
-//DONE: intialize a process
-Process::Process(int id): pidid_(id) {
-    prev_actjif_ = LinuxParser::ActiveJiffies(pidid_);
-    prev_jif_ = LinuxParser::Jiffies();
+//DONE: intialize a process from its first sample, used as the baseline
+Process::Process(int id, const ProcSample& sample, CpuAccounting accounting)
+    : pidid_(id),
+      prev_actjif_(sample.active_jiffies),
+      prev_jif_(sample.jiffies),
+      accounting_(accounting),
+      prev_threads_(sample.threads),
+      prev_cpu_ticks_(sample.has_stat ? sample.cpu_ticks : -1),
+      track_io_(sample.has_io),
+      prev_read_bytes_(sample.read_bytes),
+      prev_write_bytes_(sample.write_bytes),
+      prev_io_time_(sample.io_time),
+      prev_time_(sample.time) {
+  has_baseline_ = accounting_ == CpuAccounting::kSchedstat ? sample.has_sched
+                                                            : sample.has_stat;
 }
 
 // DONE: Return this process's ID
@@ -25,16 +37,97 @@ int Process::Pid() const { return pidid_; }
 float Process::CpuUtilization() const {
   return cpu_util_;
 }
-// Update the process calculation
-void Process::Update(){
-    long actjif, jif;
-    actjif = LinuxParser::ActiveJiffies(pidid_);
-    jif = LinuxParser::Jiffies();
-    cpu_util_ = 1.0 * (actjif - prev_actjif_) / (jif - prev_jif_);
-    prev_actjif_ = actjif;
-    prev_jif_ = jif;
+// Update the process calculation from the sample read after the interval
+void Process::Update(const ProcSample& sample){
+    double elapsed =
+        std::chrono::duration<double>(sample.time - prev_time_).count();
+    prev_time_ = sample.time;
+
+    if (accounting_ == CpuAccounting::kSchedstat) {
+      UpdateSchedStat(sample, elapsed);
+    } else if (sample.has_stat) {
+      // without a baseline the delta would be the whole lifetime
+      if (has_baseline_ && sample.jiffies > prev_jif_) {
+        cpu_util_ = 1.0 * (sample.active_jiffies - prev_actjif_) /
+                    (sample.jiffies - prev_jif_);
+      }
+      prev_actjif_ = sample.active_jiffies;
+      prev_jif_ = sample.jiffies;
+      has_baseline_ = true;
+    }
+
+    // io is skipped for a process that did not run, it did no I/O then. The
+    // counters are cumulative, so the last read stays a valid baseline
+    if (!sample.has_io) {
+      read_rate_ = write_rate_ = 0.0;
+      return;
+    }
+    double io_elapsed =
+        std::chrono::duration<double>(sample.io_time - prev_io_time_).count();
+    if (track_io_ && io_elapsed > 0) {
+      read_rate_ = (sample.read_bytes - prev_read_bytes_) / io_elapsed;
+      write_rate_ = (sample.write_bytes - prev_write_bytes_) / io_elapsed;
+    }
+    track_io_ = true;
+    prev_read_bytes_ = sample.read_bytes;
+    prev_write_bytes_ = sample.write_bytes;
+    prev_io_time_ = sample.io_time;
+}
+
+// On-cpu ns over the wall-clock ns of every online core, so 1.0 still means
+// the whole machine like the jiffies based figure. The deltas are taken per
+// thread, one that is new (or whose tid was reused) counts from 0. A thread
+// that exited takes its schedstat with them, utime + stime of the thread
+// group keeps its time at clock tick resolution: the larger of the two counts
+void Process::UpdateSchedStat(const ProcSample& sample, double elapsed) {
+    static const long ticks_per_second = sysconf(_SC_CLK_TCK);
+    long prev_cpu_ticks = prev_cpu_ticks_;
+    prev_cpu_ticks_ = sample.has_stat ? sample.cpu_ticks : -1;
+    // a missed sample leaves a baseline of unknown age, start over
+    if (!sample.has_sched) {
+      has_baseline_ = false;
+      prev_threads_.clear();
+      return;
+    }
+    // without a baseline the delta would be the whole lifetime
+    if (has_baseline_) {
+      long run_ns{0}, wait_ns{0}, slices{0};
+      for (const auto& thread : sample.threads) {
+        const ThreadSched& curr = thread.second;
+        ThreadSched prev;
+        auto found = prev_threads_.find(thread.first);
+        if (found != prev_threads_.end() &&
+            found->second.run_ns <= curr.run_ns)
+          prev = found->second;
+        run_ns += curr.run_ns - prev.run_ns;
+        wait_ns += curr.wait_ns - prev.wait_ns;
+        slices += curr.timeslices - prev.timeslices;
+      }
+      if (sample.has_stat && prev_cpu_ticks >= 0 && ticks_per_second > 0)
+        run_ns = std::max(run_ns, (sample.cpu_ticks - prev_cpu_ticks) *
+                                      (1000000000 / ticks_per_second));
+      static const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+      if (elapsed > 0 && cores > 0)
+        cpu_util_ = run_ns / (elapsed * 1e9 * cores);
+      sched_latency_ = slices > 0 ? wait_ns / (slices * 1e6) : 0.0;
+    }
+    has_baseline_ = true;
+    prev_threads_ = sample.threads;
 }
 
+// Return the average run queue wait per timeslice over the last interval
+float Process::SchedLatency() const { return sched_latency_; }
+
+// Return how the CPU utilization of this process is measured
+CpuAccounting Process::Accounting() const { return accounting_; }
+
+// Return the storage read / write rates measured over the last interval
+float Process::ReadRate() const { return read_rate_; }
+float Process::WriteRate() const { return write_rate_; }
+
+// Whether /proc/<pid>/io could be read for this process
+bool Process::IoTracked() const { return track_io_; }
+
 // DONE: Return the command that generated this process
 string Process::Command() const { return LinuxParser::Command(pidid_); }
 
@@ -1,4 +1,76 @@
 #include "processor.h"
+
+#include <vector>
+
 #include "linux_parser.h"
-// TODO: Return the aggregate CPU utilization
-float Processor::Utilization() { return LinuxParser::CpuUtilization(); }
\ No newline at end of file
+
+using std::vector;
+
+namespace {
+// Busy share of the jiffies elapsed between two cpu lines of /proc/stat
+float Busy(const vector<long>& prev, const vector<long>& curr) {
+  using namespace LinuxParser;
+  long idle = curr[kIdle_] + curr[kIOwait_] - prev[kIdle_] - prev[kIOwait_];
+  long nonidle = 0;
+  for (int state : {kUser_, kNice_, kSystem_, kIRQ_, kSoftIRQ_, kSteal_})
+    nonidle += curr[state] - prev[state];
+  if (idle + nonidle <= 0) return 0.0;
+  return 1.0 * nonidle / (idle + nonidle);
+}
+}  // namespace
+
+// Take the baseline sample so the first Update() has something to diff with
+Processor::Processor() : prev_stats_(LinuxParser::CpuStats(core_ids_)) {
+  if (!prev_stats_.empty()) core_util_.assign(prev_stats_.size() - 1, 0.0);
+}
+
+// DONE: Return the aggregate CPU utilization over the last interval
+float Processor::Utilization() { return cpu_util_; }
+
+// Return the utilization of every core over the last interval
+vector<float> Processor::CoreUtilization() const { return core_util_; }
+
+// Return the CPU numbers of the cores, they skip the offline ones
+vector<int> Processor::CoreIds() const { return core_ids_; }
+
+// Return the share of the last interval spent in each state
+float Processor::User() const { return user_; }
+float Processor::System() const { return system_; }
+float Processor::IOwait() const { return iowait_; }
+float Processor::Steal() const { return steal_; }
+
+// Update the aggregate and per-core figures from a single /proc/stat read,
+// as returned by LinuxParser::CpuStats
+void Processor::Update(const vector<vector<long>>& stats,
+                       const vector<int>& ids) {
+  using namespace LinuxParser;
+  if (stats.empty()) return;
+  // a core went on / offline, start over from this sample
+  if (ids != core_ids_) {
+    prev_stats_ = stats;
+    core_ids_ = ids;
+    core_util_.assign(stats.size() - 1, 0.0);
+    return;
+  }
+
+  cpu_util_ = Busy(prev_stats_[0], stats[0]);
+  for (size_t i = 1; i < stats.size(); i++)
+    core_util_[i - 1] = Busy(prev_stats_[i], stats[i]);
+
+  const vector<long>& prev = prev_stats_[0];
+  const vector<long>& curr = stats[0];
+  long total = 0;
+  for (int state = kUser_; state <= kSteal_; state++)
+    total += curr[state] - prev[state];
+  if (total > 0) {
+    user_ = 1.0 * (curr[kUser_] + curr[kNice_] - prev[kUser_] - prev[kNice_]) /
+            total;
+    system_ = 1.0 *
+              (curr[kSystem_] + curr[kIRQ_] + curr[kSoftIRQ_] -
+               prev[kSystem_] - prev[kIRQ_] - prev[kSoftIRQ_]) /
+              total;
+    iowait_ = 1.0 * (curr[kIOwait_] - prev[kIOwait_]) / total;
+    steal_ = 1.0 * (curr[kSteal_] - prev[kSteal_]) / total;
+  }
+  prev_stats_ = stats;
+}
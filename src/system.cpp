@@ -6,18 +6,49 @@
 #include <cstddef>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "linux_parser.h"
 #include "process.h"
 #include "processor.h"
 
+namespace {
+// until the first ranking the pass after the baseline comes right away
+auto const kBootstrapInterval{std::chrono::milliseconds(100)};
+// pids sampled before their rows are handed over to the UI thread
+size_t const kChunkPids{2048};
+}  // namespace
+
 using std::set;
 using std::size_t;
 using std::string;
 using std::vector;
 
-System::System(){this->Refresh();}
+// Schedstat accounting falls back to jiffies if the kernel lacks schedstat,
+// the io_uring reader falls back to synchronous reads if it is not supported
+System::System(CpuAccounting accounting, bool io_uring)
+    : accounting_(accounting),
+      reader_(io_uring),
+      start_(std::chrono::steady_clock::now()) {
+  if (accounting_ == CpuAccounting::kSchedstat) {
+    bool schedstat{false};
+    reader_.Read({LinuxParser::kProcDirectory + std::to_string(getpid()) +
+                  LinuxParser::kSchedstatFilename},
+                 [&schedstat](size_t, const string&) { schedstat = true; });
+    if (!schedstat) accounting_ = CpuAccounting::kJiffies;
+  }
+  io_uring_ = reader_.UsingIoUring();
+  // minimal scan so the first frame can list the pids without reading any
+  // per-process file; the first pass, the baseline, starts right away
+  for (int id : LinuxParser::Pids()) {
+    index_[id] = processes_.size();
+    processes_.push_back(Process(id, ProcSample(), accounting_));
+  }
+  Refresh();
+}
 
 // DONE: Return the system's CPU
 Processor& System::Cpu() { return cpu_; }
@@ -43,21 +74,268 @@ int System::TotalProcesses() const { return LinuxParser::TotalProcesses(); }
 // DONE: Return the number of seconds since the system started running
 long int System::UpTime() const { return LinuxParser::UpTime(); }
 
+// Return the 1, 5 and 15 minutes load averages
+vector<float> System::LoadAverage() const { return LinuxParser::LoadAverage(); }
+
+// Return the avg10 pressure stall shares, false if the kernel has no PSI
+bool System::CpuPressure(float& some, float& full) const {
+  return LinuxParser::Pressure(LinuxParser::kCpuPressureFilename, some, full);
+}
+bool System::MemoryPressure(float& some, float& full) const {
+  return LinuxParser::Pressure(LinuxParser::kMemoryPressureFilename, some,
+                               full);
+}
+bool System::IoPressure(float& some, float& full) const {
+  return LinuxParser::Pressure(LinuxParser::kIoPressureFilename, some, full);
+}
+
+// Return the system-wide disk and network rates over the last interval
+float System::DiskReadRate() const { return disk_read_rate_; }
+float System::DiskWriteRate() const { return disk_write_rate_; }
+float System::NetRxRate() const { return net_rx_rate_; }
+float System::NetTxRate() const { return net_tx_rate_; }
+
+// Number of rows on screen, these always get their I/O sampled
+void System::IoVisible(size_t n) { io_visible_ = n; }
+
+// Return how the process CPU utilization is measured
+CpuAccounting System::Accounting() const { return accounting_; }
+
+// Whether the per-process files are read through io_uring
+bool System::UsingIoUring() const { return io_uring_; }
+
+// Return the syscalls and the time spent by the last pass over /proc
+long System::TickSyscalls() const { return tick_syscalls_; }
+float System::TickMs() const { return tick_ms_; }
+
+// Return the number of passes over /proc applied so far
+int System::Passes() const { return passes_; }
+
+// Whether the processes carry CPU figures yet
+bool System::Ranked() const { return ranked_; }
+
+// Time between the starts of two passes once the first ranking is in
+void System::Interval(std::chrono::milliseconds interval) {
+  interval_ = interval;
+}
+
+// Read the per-process counters of every pid in two batches: the CPU
+// counters first, then /proc/<pid>/io of the pids that may have done I/O
+vector<ProcSample> System::Sample(const vector<int>& pids) {
+  enum Kind { kStat, kSchedstat, kIo };
+  vector<ProcSample> samples(pids.size());
+  vector<string> paths;
+  vector<size_t> owners;  // sample each path belongs to
+  vector<Kind> kinds;
+  vector<int> tids;  // thread of each schedstat path
+  long jiffies{0};
+  if (accounting_ == CpuAccounting::kJiffies) jiffies = LinuxParser::Jiffies();
+  auto on_read = [&](size_t index, const string& content) {
+    ProcSample& sample = samples[owners[index]];
+    switch (kinds[index]) {
+      case kStat:
+        sample.active_jiffies = LinuxParser::ParseActiveJiffies(content);
+        sample.cpu_ticks = LinuxParser::ParseCpuTicks(content);
+        sample.jiffies = jiffies;
+        LinuxParser::ParseIoDelay(content, sample.state, sample.blkio_ticks);
+        sample.has_stat = true;
+        sample.time = std::chrono::steady_clock::now();
+        break;
+      case kSchedstat: {
+        ThreadSched thread;
+        if (LinuxParser::ParseSchedStat(content, thread.run_ns, thread.wait_ns,
+                                        thread.timeslices)) {
+          sample.threads[tids[index]] = thread;
+          sample.run_ns += thread.run_ns;
+          sample.has_sched = true;
+        }
+        sample.time = std::chrono::steady_clock::now();
+        break;
+      }
+      case kIo:
+        sample.has_io = LinuxParser::ParseIoBytes(content, sample.read_bytes,
+                                                  sample.write_bytes);
+        sample.io_time = std::chrono::steady_clock::now();
+        break;
+    }
+  };
+  for (size_t i = 0; i < pids.size(); i++) {
+    string directory = LinuxParser::kProcDirectory + std::to_string(pids[i]);
+    if (accounting_ == CpuAccounting::kSchedstat) {
+      string tasks = directory + LinuxParser::kTaskDirectory;
+      for (int tid : reader_.List(tasks)) {
+        paths.push_back(tasks + std::to_string(tid) +
+                        LinuxParser::kSchedstatFilename);
+        owners.push_back(i);
+        kinds.push_back(kSchedstat);
+        tids.push_back(tid);
+      }
+    }
+    // schedstat accounting needs stat too, for the time of exited threads
+    paths.push_back(directory + LinuxParser::kStatFilename);
+    owners.push_back(i);
+    kinds.push_back(kStat);
+    tids.push_back(0);
+  }
+  reader_.Read(paths, on_read);
+
+  // I/O pre-filter: a process that was not scheduled and did not wait for
+  // block I/O since the last pass can not have issued any read/write. New
+  // pids, the ones that ran, the ones in D state or with a growing blkio
+  // delay and the ones on screen get their /proc/<pid>/io read
+  paths.clear();
+  owners.clear();
+  kinds.clear();
+  for (size_t i = 0; i < pids.size(); i++) {
+    const ProcSample& sample = samples[i];
+    long counter = sample.run_ns + sample.active_jiffies + sample.blkio_ticks;
+    auto last = activity_.find(pids[i]);
+    if (last == activity_.end() || last->second != counter ||
+        sample.state == 'D' || io_pids_.count(pids[i]) > 0) {
+      paths.push_back(LinuxParser::kProcDirectory + std::to_string(pids[i]) +
+                      LinuxParser::kIoFilename);
+      owners.push_back(i);
+      kinds.push_back(kIo);
+    }
+    activity_[pids[i]] = counter;
+  }
+  reader_.Read(paths, on_read);
+  return samples;
+}
+
 // DONE: Refresh the process to ensure what process is living now
+// Starts the next pass on another thread; nothing but Update() may touch
+// reader_, io_pids_, activity_ or accounting_ until it has finished
 void System::Refresh() {
-  processes_.clear();
-  vector<int> pidid = LinuxParser::Pids();
-  for (int id : pidid) {
-    Process proc(id);
-    processes_.push_back(proc);
+  pending_ = std::async(std::launch::async, &System::Collect, this);
+}
+
+// List the pids and read their counters along with the CPU, disk and net
+// totals, so every panel describes the same interval. The samples are handed
+// over every kChunkPids pids for Update() to fill the rows in
+System::Pass System::Collect() {
+  Pass pass;
+  auto start = std::chrono::steady_clock::now();
+  long syscalls = reader_.Syscalls();
+  pass.cpu_stats = LinuxParser::CpuStats(pass.cpu_ids);
+  LinuxParser::DiskBytes(pass.disk_read, pass.disk_write);
+  LinuxParser::NetworkBytes(pass.net_rx, pass.net_tx);
+  pass.time = std::chrono::steady_clock::now();
+  pass.pids = reader_.List(LinuxParser::kProcDirectory);
+  for (size_t first = 0; first < pass.pids.size(); first += kChunkPids) {
+    Chunk chunk;
+    chunk.pids.assign(
+        pass.pids.begin() + first,
+        pass.pids.begin() + std::min(first + kChunkPids, pass.pids.size()));
+    chunk.samples = Sample(chunk.pids);
+    std::lock_guard<std::mutex> lock(chunks_mutex_);
+    chunks_.push_back(std::move(chunk));
   }
+  // forget the pids that exited
+  std::unordered_map<int, long> activity;
+  for (int pid : pass.pids) activity[pid] = activity_[pid];
+  activity_ = std::move(activity);
+  pass.syscalls = reader_.Syscalls() - syscalls;
+  pass.ms = std::chrono::duration<float, std::milli>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  return pass;
 }
 
+// Record the time to the first frame and to the first frame with CPU figures
+void System::FrameDrawn() {
+  float elapsed = std::chrono::duration<float, std::milli>(
+                      std::chrono::steady_clock::now() - start_)
+                      .count();
+  if (first_frame_ms_ < 0) first_frame_ms_ = elapsed;
+  if (ranked_ && first_ranking_ms_ < 0) first_ranking_ms_ = elapsed;
+}
+
+float System::FirstFrameMs() const { return first_frame_ms_; }
+float System::FirstRankingMs() const { return first_ranking_ms_; }
+
 // DONE: Update the process
-void System::Update() {
-  for (Process &p : processes_) {
-    p.Update();
+// Never blocks: applies the chunks the running pass has handed over, then
+// the pass itself once it finished, and starts the next pass when it is due.
+// Every pass is the baseline of the next one. Returns whether anything
+// changed, i.e. whether a redraw is worth it
+bool System::Update() {
+  bool changed{false};
+  bool finished = pending_.valid() &&
+                  pending_.wait_for(std::chrono::seconds(0)) ==
+                      std::future_status::ready;
+  vector<Chunk> chunks;
+  {
+    std::lock_guard<std::mutex> lock(chunks_mutex_);
+    chunks.swap(chunks_);
+  }
+  for (const Chunk& chunk : chunks) Apply(chunk);
+  changed = !chunks.empty();
+  if (finished) {
+    Finish(pending_.get());
+    changed = true;
+  }
+  if (changed) {
+    std::sort(processes_.begin(), processes_.end());
+    std::reverse(processes_.begin(), processes_.end());
+    index_.clear();
+    for (size_t i = 0; i < processes_.size(); i++)
+      index_[processes_[i].Pid()] = i;
   }
-  std::sort(processes_.begin(), processes_.end());
-  std::reverse(processes_.begin(), processes_.end());
-}
\ No newline at end of file
+  if (finished) {
+    // the rows on screen get their io read by the next pass in any case
+    io_pids_.clear();
+    for (size_t i = 0; i < processes_.size() && i < io_visible_; i++)
+      io_pids_.insert(processes_[i].Pid());
+  }
+  if (!pending_.valid() && std::chrono::steady_clock::now() >= next_pass_)
+    Refresh();
+  return changed;
+}
+
+// The processes are kept across passes: new pids take their first sample as
+// baseline, known ones are updated in place
+void System::Apply(const Chunk& chunk) {
+  for (size_t i = 0; i < chunk.pids.size(); i++) {
+    auto found = index_.find(chunk.pids[i]);
+    if (found == index_.end()) {
+      index_[chunk.pids[i]] = processes_.size();
+      processes_.push_back(
+          Process(chunk.pids[i], chunk.samples[i], accounting_));
+    } else {
+      processes_[found->second].Update(chunk.samples[i]);
+    }
+  }
+}
+
+// Drop the pids that exited and update the system-wide figures of the pass
+void System::Finish(const Pass& pass) {
+  std::unordered_set<int> alive(pass.pids.begin(), pass.pids.end());
+  processes_.erase(std::remove_if(processes_.begin(), processes_.end(),
+                                  [&alive](const Process& p) {
+                                    return alive.count(p.Pid()) == 0;
+                                  }),
+                   processes_.end());
+  cpu_.Update(pass.cpu_stats, pass.cpu_ids);
+  io_uring_ = reader_.UsingIoUring();
+  tick_syscalls_ = pass.syscalls;
+  tick_ms_ = pass.ms;
+  ranked_ = ++passes_ > 1;
+  next_pass_ = pass.time + (ranked_ ? interval_ : kBootstrapInterval);
+
+  float elapsed = std::chrono::duration<float>(pass.time - prev_time_).count();
+  if (passes_ > 1 && elapsed > 0) {
+    // totals drop when a disk or interface goes away, report 0 then
+    disk_read_rate_ =
+        std::max(0.0f, (pass.disk_read - prev_disk_read_) / elapsed);
+    disk_write_rate_ =
+        std::max(0.0f, (pass.disk_write - prev_disk_write_) / elapsed);
+    net_rx_rate_ = std::max(0.0f, (pass.net_rx - prev_net_rx_) / elapsed);
+    net_tx_rate_ = std::max(0.0f, (pass.net_tx - prev_net_tx_) / elapsed);
+  }
+  prev_disk_read_ = pass.disk_read;
+  prev_disk_write_ = pass.disk_write;
+  prev_net_rx_ = pass.net_rx;
+  prev_net_tx_ = pass.net_tx;
+  prev_time_ = pass.time;
+}